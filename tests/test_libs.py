@@ -22,3 +22,8 @@ def test_ThermophysicalTransportModels():
 def test_MulticomponentAlloy():
     """Test that `libmulticomponentAlloy.so` can be loaded."""
     cdll.LoadLibrary("libmulticomponentAlloy.so")
+
+
+def test_profiling():
+    """Test that `libmyProfiling.so` can be loaded."""
+    cdll.LoadLibrary("libmyProfiling.so")
@@ -7,6 +7,10 @@ Example:
     Run python script in case system directory:
         $ cd system
         $ python convert_vtk.py
+
+    An optional refinement factor divides the cell sizes in all three
+    directions, e.g. for the benchmark meshes:
+        $ python cylinder.py 2
 Todo:
     * None
     
@@ -16,6 +20,8 @@ Todo:
 """
 
 
+from sys import argv
+
 from numpy import pi, cos
 
 __author__ = "Bruno Lebon"
@@ -72,13 +78,16 @@ def write_vertices(
     return block
 
 
-def write_blocks(z_points=(-300.0, -57.0, -40.0, 0.0, 170.0), zmesh=1.0):
+def write_blocks(z_points=(-300.0, -57.0, -40.0, 0.0, 170.0), zmesh=1.0, refine=1.0):
     """Writes the blocks entry
 
     :param z_points: z coordinates of the boundaries of the billet and mould sections.
     :type z_points: tuple
     :param zmesh: Vertical mesh adjustment parameter.
     :type zmesh: float
+    :param refine: Refinement factor of the cells in the horizontal plane,
+        the vertical cell size is set by zmesh.
+    :type refine: float
     :return: string containing the blockMeshDict blocks entry
     :rtype: string
 
@@ -86,9 +95,11 @@ def write_blocks(z_points=(-300.0, -57.0, -40.0, 0.0, 170.0), zmesh=1.0):
     block = "blocks\n"
     block += "(\n"
     vertex = 0
+    square_cells = int(round(20 * refine))
+    curve_cells = int(round(10 * refine))
     for i in range(len(z_points) - 1):
         cells = int((z_points[i + 1] - z_points[i]) / zmesh)
-        block += "    hex ({:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d}) domain (20 20 {:2d}) simpleGrading (1 1 1) // {:2d}\n".format(
+        block += "    hex ({:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d}) domain ({:2d} {:2d} {:2d}) simpleGrading (1 1 1) // {:2d}\n".format(
             1 + 8 * i,
             0 + 8 * i,
             3 + 8 * i,
@@ -97,11 +108,13 @@ def write_blocks(z_points=(-300.0, -57.0, -40.0, 0.0, 170.0), zmesh=1.0):
             8 + 8 * i,
             11 + 8 * i,
             10 + 8 * i,
+            square_cells,
+            square_cells,
             cells,
             vertex,
         )
         vertex += 1
-        block += "    hex ({:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d}) domain (10 20 {:2d}) simpleGrading (1 1 1) // {:2d}\n".format(
+        block += "    hex ({:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d}) domain ({:2d} {:2d} {:2d}) simpleGrading (1 1 1) // {:2d}\n".format(
             0 + 8 * i,
             4 + 8 * i,
             7 + 8 * i,
@@ -110,11 +123,13 @@ def write_blocks(z_points=(-300.0, -57.0, -40.0, 0.0, 170.0), zmesh=1.0):
             12 + 8 * i,
             15 + 8 * i,
             11 + 8 * i,
+            curve_cells,
+            square_cells,
             cells,
             vertex,
         )
         vertex += 1
-        block += "    hex ({:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d}) domain (10 20 {:2d}) simpleGrading (1 1 1) // {:2d}\n".format(
+        block += "    hex ({:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d}) domain ({:2d} {:2d} {:2d}) simpleGrading (1 1 1) // {:2d}\n".format(
             3 + 8 * i,
             7 + 8 * i,
             6 + 8 * i,
@@ -123,11 +138,13 @@ def write_blocks(z_points=(-300.0, -57.0, -40.0, 0.0, 170.0), zmesh=1.0):
             15 + 8 * i,
             14 + 8 * i,
             10 + 8 * i,
+            curve_cells,
+            square_cells,
             cells,
             vertex,
         )
         vertex += 1
-        block += "    hex ({:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d}) domain (10 20 {:2d}) simpleGrading (1 1 1) // {:2d}\n".format(
+        block += "    hex ({:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d}) domain ({:2d} {:2d} {:2d}) simpleGrading (1 1 1) // {:2d}\n".format(
             2 + 8 * i,
             6 + 8 * i,
             5 + 8 * i,
@@ -136,11 +153,13 @@ def write_blocks(z_points=(-300.0, -57.0, -40.0, 0.0, 170.0), zmesh=1.0):
             14 + 8 * i,
             13 + 8 * i,
             9 + 8 * i,
+            curve_cells,
+            square_cells,
             cells,
             vertex,
         )
         vertex += 1
-        block += "    hex ({:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d}) domain (10 20 {:2d}) simpleGrading (1 1 1) // {:2d}\n".format(
+        block += "    hex ({:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d} {:2d}) domain ({:2d} {:2d} {:2d}) simpleGrading (1 1 1) // {:2d}\n".format(
             1 + 8 * i,
             5 + 8 * i,
             4 + 8 * i,
@@ -149,6 +168,8 @@ def write_blocks(z_points=(-300.0, -57.0, -40.0, 0.0, 170.0), zmesh=1.0):
             13 + 8 * i,
             12 + 8 * i,
             8 + 8 * i,
+            curve_cells,
+            square_cells,
             cells,
             vertex,
         )
@@ -307,6 +328,7 @@ def write_blockMeshDict(
     diameter=155.0,
     z_points=(-300.0, -57.0, -40.0, 0.0, 170.0),
     zmesh=1.0,
+    refine=1.0,
 ):
     """Assembles the blockMeshDict file contents
 
@@ -317,6 +339,9 @@ def write_blockMeshDict(
     :return: string containing the blockMeshDict file contents
     :param zmesh: Vertical mesh adjustment parameter.
     :type zmesh: float
+    :param refine: Refinement factor of the cells in the horizontal plane,
+        the vertical cell size is set by zmesh.
+    :type refine: float
     :rtype: string
 
     """
@@ -340,7 +365,7 @@ FoamFile
 convertToMeters 0.001;\n\n"""
     block += write_vertices(diameter=diameter, z_points=z_points)
     block += "\n"
-    block += write_blocks(z_points=z_points, zmesh=zmesh)
+    block += write_blocks(z_points=z_points, zmesh=zmesh, refine=refine)
     block += "\n"
     block += write_edges(diameter=diameter, z_points=z_points)
     block += "\n"
@@ -358,12 +383,14 @@ convertToMeters 0.001;\n\n"""
 if __name__ == "__main__":
     DIAMETER = 155.0
     ZMESH = 2.0
+    REFINE = float(argv[1]) if len(argv) > 1 else 1.0
     Z_POINTS = (-300.0, -57.0, -40.0, 0.0, 170.0)
     with open("blockMeshDict", "w") as f:
         f.write(
             write_blockMeshDict(
                 diameter=DIAMETER,
                 z_points=Z_POINTS,
-                zmesh=ZMESH,
+                zmesh=ZMESH / REFINE,
+                refine=REFINE,
             )
         )
@@ -7,6 +7,10 @@ Example:
     Run python script in case system directory:
         $ cd system
         $ python convert_vtk.py
+
+    An optional refinement factor divides the radial and vertical cell
+    sizes, e.g. for the benchmark meshes:
+        $ python cylinder.py 2
 Todo:
     * None
     
@@ -17,6 +21,8 @@ Todo:
 
 from __future__ import division, print_function
 
+from sys import argv
+
 from numpy import pi, cos, sin
 
 __author__ = "Bruno Lebon"
@@ -257,6 +263,7 @@ if __name__ == "__main__":
     DIAMETER = 450.0
     RMESH = 5.5
     ZMESH = 2.0
+    REFINE = float(argv[1]) if len(argv) > 1 else 1.0
     Z_POINTS = (-900.0, -400.0, -70.0, -40.0, -10.0, 0.0)
     with open("blockMeshDict", "w") as f:
         f.write(
@@ -264,7 +271,7 @@ if __name__ == "__main__":
                 angle=ANGLE,
                 diameter=DIAMETER,
                 z_points=Z_POINTS,
-                rmesh=RMESH,
-                zmesh=ZMESH,
+                rmesh=RMESH / REFINE,
+                zmesh=ZMESH / REFINE,
             )
         )
@@ -93,6 +93,38 @@ struct TemperatureVectors
     double tolerance;
 };
 
+// Sump records of the transient run and of the LTS run of Allrun.LTS
+const string transient_sump_file{"../../postProcessing/sump/0/sump.dat"};
+const string lts_sump_file{"../../LTS/postProcessing/sump/0/sump.dat"};
+
+// Read the liquidus and solidus depths of the last line of a sump record
+vector<double> read_sump_depths(string filename)
+{
+    ifstream datafile(filename);
+    vector<double> depths;
+    vector<string> line_array;
+    string line;
+
+    while(getline(datafile, line))
+    {
+        line_array.clear();
+        boost::split(line_array, line, boost::is_any_of("\t "), boost::token_compress_on);
+        if ( strcmp(line_array[0].c_str(), "#") == 0 ) continue; // Skip headers and comments
+        depths = {stod(line_array[1]), stod(line_array[2])}; // Liquidus and solidus depths [m]
+    }
+
+    return depths;
+}
+
+// Skip the LTS comparison unless Allrun.LTS has been run
+struct LTSRun
+{
+    boost::test_tools::assertion_result operator()(utf::test_unit_id)
+    {
+        return fs::exists(fs::path{lts_sump_file});
+    }
+};
+
 struct F {
   F() { BOOST_TEST_MESSAGE( "\nSetup fixture" ); }
   ~F() { BOOST_TEST_MESSAGE( "Teardown fixture" ); }
@@ -121,4 +153,22 @@ BOOST_FIXTURE_TEST_SUITE(CheckIfTemperaturesMatchExpectedValues, F);
         temperatures.boost_check();
     }
 
+    BOOST_AUTO_TEST_CASE(CheckIfLTSSumpDepthsMatchTransient, * utf::precondition(LTSRun()))
+    {
+        const double depth_tolerance{0.005}; // [m]
+
+        BOOST_ASSERT_MSG(fs::exists(fs::path{transient_sump_file}), "-- Transient sump record not found!");
+
+        vector<double> transient{read_sump_depths(transient_sump_file)};
+        vector<double> lts{read_sump_depths(lts_sump_file)};
+
+        BOOST_REQUIRE_EQUAL(transient.size(), 2);
+        BOOST_REQUIRE_EQUAL(lts.size(), 2);
+
+        BOOST_TEST_MESSAGE("Checking LTS liquidus depth");
+        BOOST_CHECK_SMALL(lts[0] - transient[0], depth_tolerance);
+        BOOST_TEST_MESSAGE("Checking LTS solidus depth");
+        BOOST_CHECK_SMALL(lts[1] - transient[1], depth_tolerance);
+    }
+
 BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
@@ -0,0 +1,433 @@
+#!/usr/bin/env python3
+"""Runs the directChillFoam performance benchmark on the tutorial cases.
+
+Each tutorial case is copied to the output directory and meshed at several
+resolutions with its system/cylinder.py script. The solver is then run for a
+fixed number of time steps in serial and on several processor counts. The
+throughput in cell-updates per second, the strong-scaling efficiency and the
+weak-scaling efficiency are reported. The strong-scaling efficiency on the
+gated mesh, which unlike the throughput does not depend on the speed of the
+machine, is compared against a stored baseline.
+
+Example:
+    Run python script with the OpenFOAM environment sourced:
+
+        $ python3 benchmark.py --output /tmp/benchmark
+
+    Record the results as the new baseline:
+
+        $ python3 benchmark.py --output /tmp/benchmark --write-baseline
+
+Todo:
+    * None
+
+.. _Google Python Style Guide:
+   http://google.github.io/styleguide/pyguide.html
+
+"""
+
+from __future__ import division, print_function
+
+import argparse
+import json
+import os
+import platform
+import re
+import shutil
+import subprocess
+import sys
+
+__author__ = "Bruno Lebon"
+__copyright__ = "Copyright, 2023, Brunel University London"
+__credits__ = ["Bruno Lebon"]
+__email__ = "Bruno.Lebon@brunel.ac.uk"
+__status__ = "Production"
+
+
+BENCHMARK_DIR = os.path.dirname(os.path.abspath(__file__))
+TUTORIALS_DIR = os.path.dirname(BENCHMARK_DIR)
+CASES = ("Vreeman2002", "Lebon2020", "Subroto2021")
+
+
+def run_application(args, case_dir, log_name):
+    """Runs an OpenFOAM application and writes its output to a log file
+
+    :param args: Command line of the application.
+    :type args: list
+    :param case_dir: Case directory in which the application is run.
+    :type case_dir: str
+    :param log_name: Name of the log file in the case directory.
+    :type log_name: str
+    :return: contents of the log file
+    :rtype: string
+
+    """
+    log_file = os.path.join(case_dir, log_name)
+    with open(log_file, "w") as f:
+        status = subprocess.call(
+            args, cwd=case_dir, stdout=f, stderr=subprocess.STDOUT
+        )
+    if status != 0:
+        raise RuntimeError(f"{' '.join(args)} failed, see {log_file}")
+    with open(log_file) as f:
+        return f.read()
+
+
+def foam_dictionary(case_dir, dictionary, entry, value=None, remove=False):
+    """Reads, sets or removes an entry of a case dictionary with foamDictionary
+
+    :param case_dir: Case directory.
+    :type case_dir: str
+    :param dictionary: Path of the dictionary relative to the case directory.
+    :type dictionary: str
+    :param entry: Name of the entry.
+    :type entry: str
+    :param value: New value of the entry, None to read it.
+    :type value: str
+    :param remove: Remove the entry instead.
+    :type remove: bool
+    :return: value of the entry when reading
+    :rtype: string
+
+    """
+    args = ["foamDictionary", dictionary, "-entry", entry]
+    if remove:
+        args += ["-remove"]
+    elif value is None:
+        args += ["-value"]
+    else:
+        args += ["-set", str(value)]
+    return subprocess.check_output(args, cwd=case_dir).decode().strip()
+
+
+def setup_mesh(case, refine, steps, output_dir):
+    """Copies a tutorial case, meshes it and initialises its fields
+
+    The time control is replaced by a fixed number of time steps without
+    writing or function objects, so that only the solver is timed.
+
+    :param case: Name of the tutorial case.
+    :type case: str
+    :param refine: Mesh refinement factor passed to system/cylinder.py.
+    :type refine: int
+    :param steps: Number of time steps to run.
+    :type steps: int
+    :param output_dir: Benchmark output directory.
+    :type output_dir: str
+    :return: case directory and number of cells
+    :rtype: tuple
+
+    """
+    case_dir = os.path.join(output_dir, case, f"refine{refine}", "mesh")
+    if os.path.isdir(case_dir):
+        shutil.rmtree(case_dir)
+    for folder in ("0", "constant", "system"):
+        shutil.copytree(
+            os.path.join(TUTORIALS_DIR, case, folder),
+            os.path.join(case_dir, folder),
+        )
+
+    run_application(
+        [sys.executable, "cylinder.py", str(refine)],
+        os.path.join(case_dir, "system"),
+        "log.cylinder",
+    )
+    log = run_application(["blockMesh"], case_dir, "log.blockMesh")
+    n_cells = int(re.findall(r"nCells:\s*(\d+)", log)[-1])
+    run_application(["setFields"], case_dir, "log.setFields")
+
+    control_dict = "system/controlDict"
+    start_time = float(foam_dictionary(case_dir, control_dict, "startTime"))
+    delta_t = float(foam_dictionary(case_dir, control_dict, "deltaT"))
+    settings = {
+        "startFrom": "startTime",
+        "stopAt": "endTime",
+        "endTime": f"{start_time + steps * delta_t:.12g}",
+        "adjustTimeStep": "no",
+        "writeControl": "timeStep",
+        "writeInterval": steps + 1,
+    }
+    for entry, value in settings.items():
+        foam_dictionary(case_dir, control_dict, entry, value)
+    foam_dictionary(case_dir, control_dict, "functions", remove=True)
+
+    return case_dir, n_cells
+
+
+def run_solver(mesh_dir, ranks):
+    """Decomposes the meshed case if necessary and runs the solver
+
+    :param mesh_dir: Directory of the meshed case.
+    :type mesh_dir: str
+    :param ranks: Number of processors.
+    :type ranks: int
+    :return: wall-clock time at the end of each time step (s)
+    :rtype: list
+
+    """
+    case_dir = os.path.join(os.path.dirname(mesh_dir), f"np{ranks}")
+    if os.path.isdir(case_dir):
+        shutil.rmtree(case_dir)
+    shutil.copytree(
+        mesh_dir, case_dir, ignore=shutil.ignore_patterns("log.*")
+    )
+
+    if ranks == 1:
+        args = ["directChillFoam"]
+    else:
+        dictionary = "system/decomposeParDict"
+        foam_dictionary(case_dir, dictionary, "numberOfSubdomains", ranks)
+        foam_dictionary(case_dir, dictionary, "method", "scotch")
+        run_application(["decomposePar"], case_dir, "log.decomposePar")
+        args = ["mpirun", "-np", str(ranks), "directChillFoam", "-parallel"]
+
+    log = run_application(args, case_dir, "log.directChillFoam")
+    return [
+        float(t)
+        for t in re.findall(
+            r"^ExecutionTime = .* ClockTime = ([0-9.eE+-]+) s", log, re.MULTILINE
+        )
+    ]
+
+
+def measure(case, refine, ranks, n_cells, clock_times):
+    """Returns the throughput of a benchmark run
+
+    The first time step includes the start-up cost and is excluded.
+
+    :param case: Name of the tutorial case.
+    :type case: str
+    :param refine: Mesh refinement factor.
+    :type refine: int
+    :param ranks: Number of processors.
+    :type ranks: int
+    :param n_cells: Number of cells of the mesh.
+    :type n_cells: int
+    :param clock_times: Wall-clock time at the end of each time step (s).
+    :type clock_times: list
+    :return: benchmark result
+    :rtype: dict
+
+    """
+    if len(clock_times) < 2:
+        raise RuntimeError(f"{case} refine{refine} np{ranks}: too few time steps")
+    steps = len(clock_times) - 1
+    seconds_per_step = (clock_times[-1] - clock_times[0]) / steps
+    return {
+        "case": case,
+        "refine": refine,
+        "ranks": ranks,
+        "cells": n_cells,
+        "steps": steps,
+        "secondsPerStep": seconds_per_step,
+        "cellUpdatesPerSecond": n_cells / max(seconds_per_step, 1e-12),
+    }
+
+
+def add_scaling(results):
+    """Adds the strong- and weak-scaling efficiencies to the results
+
+    The strong-scaling efficiency compares each run with the serial run on
+    the same mesh. The weak-scaling efficiency compares the throughput per
+    processor with that of the serial run on the coarsest mesh, for the mesh
+    whose number of cells per processor is closest to the coarsest mesh.
+
+    :param results: Benchmark results.
+    :type results: list
+
+    """
+    serial = {
+        (r["case"], r["refine"]): r["cellUpdatesPerSecond"]
+        for r in results
+        if r["ranks"] == 1
+    }
+
+    for r in results:
+        base = serial.get((r["case"], r["refine"]))
+        if base:
+            r["strongEfficiency"] = r["cellUpdatesPerSecond"] / (r["ranks"] * base)
+
+    for case in set(r["case"] for r in results):
+        runs = [r for r in results if r["case"] == case]
+        coarsest = min(r["refine"] for r in runs)
+        base = [r for r in runs if r["refine"] == coarsest and r["ranks"] == 1]
+        if not base:
+            continue
+        for ranks in set(r["ranks"] for r in runs):
+            weak = min(
+                (r for r in runs if r["ranks"] == ranks),
+                key=lambda r: abs(r["cells"] / ranks - base[0]["cells"]),
+            )
+            weak["weakEfficiency"] = (
+                weak["cellUpdatesPerSecond"] / ranks
+            ) / base[0]["cellUpdatesPerSecond"]
+
+
+def gated_runs(results, refine):
+    """Returns the parallel runs on the gated mesh
+
+    :param results: Benchmark results.
+    :type results: list
+    :param refine: Mesh refinement factor of the gated mesh.
+    :type refine: int
+    :return: gated runs
+    :rtype: list
+
+    """
+    return [r for r in results if r["refine"] == refine and r["ranks"] > 1]
+
+
+def compare(results, baseline, refine, tolerance):
+    """Compares the strong-scaling efficiency against the baseline
+
+    Only the parallel runs on the gated mesh are compared. A run fails when
+    it has no baseline entry, or when its strong-scaling efficiency falls
+    below the baseline value by more than the relative tolerance. The
+    comparison fails when there is no run to compare.
+
+    :param results: Benchmark results.
+    :type results: list
+    :param baseline: Baseline results.
+    :type baseline: list
+    :param refine: Mesh refinement factor of the gated mesh.
+    :type refine: int
+    :param tolerance: Relative tolerance.
+    :type tolerance: float
+    :return: failure messages
+    :rtype: list
+
+    """
+    reference = {(b["case"], b["refine"], b["ranks"]): b for b in baseline}
+    runs = gated_runs(results, refine)
+    if not runs:
+        return [f"no parallel run on refine{refine} to compare"]
+
+    failures = []
+    for r in runs:
+        key = (r["case"], r["refine"], r["ranks"])
+        label = f"{r['case']} refine{r['refine']} np{r['ranks']}"
+        if key not in reference:
+            failures.append(f"{label}: no baseline entry")
+            continue
+        expected = reference[key]["strongEfficiency"]
+        limit = (1 - tolerance) * expected
+        if r["strongEfficiency"] < limit:
+            failures.append(
+                f"{label}: strongEfficiency {r['strongEfficiency']:.4g} < "
+                f"{limit:.4g} (baseline {expected:.4g})"
+            )
+    return failures
+
+
+def write_report(results, output_dir):
+    """Prints the results and writes them to benchmark.json and benchmark.csv
+
+    :param results: Benchmark results.
+    :type results: list
+    :param output_dir: Benchmark output directory.
+    :type output_dir: str
+
+    """
+    columns = (
+        "case",
+        "refine",
+        "ranks",
+        "cells",
+        "steps",
+        "secondsPerStep",
+        "cellUpdatesPerSecond",
+        "strongEfficiency",
+        "weakEfficiency",
+    )
+    with open(os.path.join(output_dir, "benchmark.json"), "w") as f:
+        json.dump(results, f, indent=4)
+    with open(os.path.join(output_dir, "benchmark.csv"), "w") as f:
+        f.write(",".join(columns) + "\n")
+        for r in results:
+            f.write(",".join(str(r.get(c, "")) for c in columns) + "\n")
+
+    print(
+        f"{'case':<12} {'refine':>6} {'ranks':>5} {'cells':>9} "
+        f"{'s/step':>10} {'cells/s':>10} {'strong':>7} {'weak':>7}"
+    )
+    for r in results:
+        strong, weak = (
+            "-" if e not in r else f"{r[e]:.3f}"
+            for e in ("strongEfficiency", "weakEfficiency")
+        )
+        print(
+            f"{r['case']:<12} {r['refine']:>6d} {r['ranks']:>5d} {r['cells']:>9d} "
+            f"{r['secondsPerStep']:>10.4g} {r['cellUpdatesPerSecond']:>10.4g} "
+            f"{strong:>7} {weak:>7}"
+        )
+
+
+def main():
+    """Runs the benchmark and returns the exit status"""
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--cases", nargs="+", default=list(CASES), choices=CASES)
+    parser.add_argument("--refinements", nargs="+", type=int, default=[1, 2])
+    parser.add_argument("--ranks", nargs="+", type=int, default=[1, 2, 4, 8])
+    parser.add_argument("--steps", type=int, default=20)
+    parser.add_argument("--output", default=os.path.join(os.getcwd(), "benchmark"))
+    parser.add_argument(
+        "--baseline", default=os.path.join(BENCHMARK_DIR, "baseline.json")
+    )
+    parser.add_argument("--tolerance", type=float, default=None)
+    parser.add_argument("--write-baseline", action="store_true")
+    args = parser.parse_args()
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    tolerance = baseline["tolerance"] if args.tolerance is None else args.tolerance
+
+    ranks = sorted(set(args.ranks) | {1})
+    max_ranks = os.cpu_count() or 1
+    for n in [n for n in ranks if n > max_ranks]:
+        print(f"Skipping {n} processors, only {max_ranks} available")
+    ranks = [n for n in ranks if n <= max_ranks]
+
+    os.makedirs(args.output, exist_ok=True)
+    results = []
+    for case in args.cases:
+        for refine in sorted(set(args.refinements) | {baseline["refine"]}):
+            mesh_dir, n_cells = setup_mesh(case, refine, args.steps, args.output)
+            for n in ranks:
+                print(
+                    f"Running {case} refine{refine} ({n_cells} cells) "
+                    f"on {n} processor(s)"
+                )
+                clock_times = run_solver(mesh_dir, n)
+                results.append(measure(case, refine, n, n_cells, clock_times))
+
+    add_scaling(results)
+    write_report(results, args.output)
+
+    if args.write_baseline:
+        baseline["description"] = (
+            "Strong-scaling efficiency recorded on "
+            f"{platform.node()} ({os.cpu_count()} cores)"
+        )
+        baseline["results"] = [
+            {
+                key: r[key]
+                for key in ("case", "refine", "ranks", "strongEfficiency")
+            }
+            for r in gated_runs(results, baseline["refine"])
+        ]
+        with open(args.baseline, "w") as f:
+            json.dump(baseline, f, indent=4)
+            f.write("\n")
+        print(f"Baseline written to {args.baseline}")
+        return 0
+
+    failures = compare(results, baseline["results"], baseline["refine"], tolerance)
+    for failure in failures:
+        print(f"FAILED {failure}")
+    if not failures:
+        print(f"Benchmark within {100 * tolerance:g}% of the baseline")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,358 @@
+#!/usr/bin/env python3
+"""Runs a parameter sweep of casting-parameter variants of a case.
+
+Each variant is a separate case run by its own directChillFoam process, or
+its own parallel run. The variants share the mesh of a baseline case: the
+polyMesh directories, including the decomposed ones, are linked rather than
+generated again, and only the fields are decomposed for each variant. Each
+variant is branched from a time of the baseline case, e.g. a converged sump,
+so that the start-up transient is not repeated. The dictionary entries and
+files of each variant are overlaid on a copy of the baseline case in
+sweep/<variant>, which then holds the results of the variant. Several
+variants are run at the same time, as many as fit on the available cores.
+
+The variants are described in a JSON file:
+
+.. code-block:: json
+
+    {
+        "branchTime": "latestTime",
+        "endTime": 900,
+        "variants": {
+            "reference": {},
+            "rohsenowHTC": {
+                "entries": {
+                    "{time}/T": {
+                        "boundaryField/water-film/htc/file": "\\"constant/HTC_T\\""
+                    }
+                }
+            },
+            "Cu5wt": {
+                "files": {"constant/soluteProperties": "soluteProperties.Cu5"}
+            }
+        }
+    }
+
+``branchTime`` is a time of the baseline case, ``latestTime``, or ``none`` to
+start from the initial conditions. ``{time}`` in a dictionary path is replaced
+by the branch time. The files are relative to the JSON file. ``concurrent``
+optionally limits the number of variants run at the same time.
+
+Example:
+    Run python script in the baseline case directory with the OpenFOAM
+    environment sourced:
+
+        $ python3 ../sweep/sweep.py ../sweep/Vreeman2002.json
+
+Todo:
+    * None
+
+.. _Google Python Style Guide:
+   http://google.github.io/styleguide/pyguide.html
+
+"""
+
+from __future__ import division, print_function
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import time
+
+__author__ = "Bruno Lebon"
+__copyright__ = "Copyright, 2023, Brunel University London"
+__credits__ = ["Bruno Lebon"]
+__email__ = "Bruno.Lebon@brunel.ac.uk"
+__status__ = "Production"
+
+
+SWEEP_DIR = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.dirname(SWEEP_DIR))
+
+from benchmark.benchmark import foam_dictionary, run_application  # noqa: E402
+
+
+def time_names(case_dir):
+    """Returns the time directories of a case in increasing order
+
+    :param case_dir: Case directory.
+    :type case_dir: str
+    :return: names of the time directories
+    :rtype: list
+
+    """
+    times = []
+    for name in os.listdir(case_dir):
+        try:
+            times.append((float(name), name))
+        except ValueError:
+            continue
+    return [name for _, name in sorted(times)]
+
+
+def processor_dirs(case_dir):
+    """Returns the processor directories of a decomposed case
+
+    :param case_dir: Case directory.
+    :type case_dir: str
+    :return: names of the processor directories
+    :rtype: list
+
+    """
+    return sorted(name for name in os.listdir(case_dir) if name.startswith("processor"))
+
+
+def branch_time(case_dir, branch):
+    """Returns the time of the baseline case the variants start from
+
+    The time directories of a decomposed case are also searched, so that a
+    time that has not been reconstructed is reported instead of branching
+    from an earlier time.
+
+    :param case_dir: Baseline case directory.
+    :type case_dir: str
+    :param branch: Time name, latestTime, or none for the initial conditions.
+    :type branch: str
+    :return: name of the time directory
+    :rtype: string
+
+    """
+    times = time_names(case_dir)
+    processors = processor_dirs(case_dir)
+    decomposed = (
+        time_names(os.path.join(case_dir, processors[0])) if processors else []
+    )
+    all_times = sorted(set(times + decomposed), key=float)
+    if not all_times:
+        raise RuntimeError(f"No time directories in {case_dir}")
+    if branch == "none":
+        target = all_times[0]
+    elif branch == "latestTime":
+        target = all_times[-1]
+    else:
+        target = branch
+    for name in times:
+        if float(name) == float(target):
+            return name
+    if any(float(name) == float(target) for name in decomposed):
+        raise RuntimeError(
+            f"Time {target} of the decomposed case {case_dir} has not been "
+            f"reconstructed, reconstruct it with reconstructPar -time {target}"
+        )
+    raise RuntimeError(f"Time {target} not found in {case_dir}")
+
+
+def setup_variant(case_dir, name, variant, start, end_time, files_dir):
+    """Creates the case of a variant from the baseline case
+
+    :param case_dir: Baseline case directory.
+    :type case_dir: str
+    :param name: Name of the variant.
+    :type name: str
+    :param variant: Entries and files of the variant.
+    :type variant: dict
+    :param start: Time the variant starts from.
+    :type start: str
+    :param end_time: End time of the variant, None to keep that of the case.
+    :type end_time: float
+    :param files_dir: Directory of the variant files.
+    :type files_dir: str
+    :return: case directory of the variant
+    :rtype: string
+
+    """
+    variant_dir = os.path.join(case_dir, "sweep", name)
+    if os.path.isdir(variant_dir):
+        shutil.rmtree(variant_dir)
+
+    shutil.copytree(
+        os.path.join(case_dir, "constant"),
+        os.path.join(variant_dir, "constant"),
+        ignore=shutil.ignore_patterns("polyMesh"),
+    )
+    os.symlink(
+        os.path.join(case_dir, "constant", "polyMesh"),
+        os.path.join(variant_dir, "constant", "polyMesh"),
+    )
+    for folder in ("system", start):
+        shutil.copytree(
+            os.path.join(case_dir, folder), os.path.join(variant_dir, folder)
+        )
+
+    for dictionary, entries in variant.get("entries", {}).items():
+        dictionary = dictionary.replace("{time}", start)
+        for entry, value in entries.items():
+            foam_dictionary(variant_dir, dictionary, entry, value)
+    for target, source in variant.get("files", {}).items():
+        shutil.copyfile(
+            os.path.join(files_dir, source),
+            os.path.join(variant_dir, target.replace("{time}", start)),
+        )
+
+    control_dict = "system/controlDict"
+    foam_dictionary(variant_dir, control_dict, "startFrom", "latestTime")
+    if end_time is not None:
+        foam_dictionary(variant_dir, control_dict, "endTime", end_time)
+
+    processors = processor_dirs(case_dir)
+    if processors:
+        for processor in processors:
+            os.makedirs(os.path.join(variant_dir, processor))
+            os.symlink(
+                os.path.join(case_dir, processor, "constant"),
+                os.path.join(variant_dir, processor, "constant"),
+            )
+        run_application(
+            ["decomposePar", "-fields", "-time", start],
+            variant_dir,
+            "log.decomposePar",
+        )
+
+    return variant_dir
+
+
+def solver_ranks(case_dir):
+    """Returns the number of processors the solver runs on for the case
+
+    :param case_dir: Case directory.
+    :type case_dir: str
+    :return: number of processors
+    :rtype: int
+
+    """
+    if not processor_dirs(case_dir):
+        return 1
+    return int(
+        foam_dictionary(case_dir, "system/decomposeParDict", "numberOfSubdomains")
+    )
+
+
+def solver_command(case_dir):
+    """Returns the command line of the solver for the case
+
+    :param case_dir: Case directory.
+    :type case_dir: str
+    :return: command line
+    :rtype: list
+
+    """
+    ranks = solver_ranks(case_dir)
+    if ranks == 1:
+        return ["directChillFoam"]
+    return ["mpirun", "-np", str(ranks), "directChillFoam", "-parallel"]
+
+
+def max_concurrent(case_dir, concurrent):
+    """Returns the number of variants that can run at the same time
+
+    Each variant runs on the processors of the baseline case, so the number
+    of variants is limited to those whose processors fit on the available
+    cores.
+
+    :param case_dir: Baseline case directory.
+    :type case_dir: str
+    :param concurrent: Requested number of variants, None for no limit.
+    :type concurrent: int
+    :return: number of variants run at the same time
+    :rtype: int
+
+    """
+    ranks = solver_ranks(case_dir)
+    cores = os.cpu_count() or 1
+    if ranks > cores:
+        raise RuntimeError(
+            f"{case_dir} is decomposed into {ranks} subdomains, "
+            f"only {cores} cores available"
+        )
+    fit = cores // ranks
+    if concurrent is None:
+        return fit
+    if concurrent > fit:
+        print(
+            f"Running {fit} instead of {concurrent} variants at the same time, "
+            f"{concurrent} x {ranks} processors exceed the {cores} cores"
+        )
+        return fit
+    return concurrent
+
+
+def run_variants(variant_dirs, concurrent):
+    """Runs the solver on the variants, a number of them at a time
+
+    :param variant_dirs: Case directory of each variant by name.
+    :type variant_dirs: dict
+    :param concurrent: Number of variants run at the same time.
+    :type concurrent: int
+    :return: exit status and wall-clock time (s) of each variant by name
+    :rtype: dict
+
+    """
+    pending = list(variant_dirs.items())
+    running = {}
+    results = {}
+    while pending or running:
+        while pending and len(running) < concurrent:
+            name, variant_dir = pending.pop(0)
+            print(f"Starting variant {name}")
+            log = open(os.path.join(variant_dir, "log.directChillFoam"), "w")
+            process = subprocess.Popen(
+                solver_command(variant_dir),
+                cwd=variant_dir,
+                stdout=log,
+                stderr=subprocess.STDOUT,
+            )
+            running[name] = (process, log, time.time())
+        for name, (process, log, start) in list(running.items()):
+            if process.poll() is not None:
+                log.close()
+                results[name] = (process.returncode, time.time() - start)
+                print(f"Finished variant {name} with status {process.returncode}")
+                del running[name]
+        time.sleep(1)
+    return results
+
+
+def main():
+    """Sets up and runs the sweep and returns the exit status"""
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("variants", help="JSON file describing the variants")
+    parser.add_argument("--case", default=os.getcwd(), help="baseline case")
+    parser.add_argument("--concurrent", type=int, default=None)
+    args = parser.parse_args()
+
+    with open(args.variants) as f:
+        sweep = json.load(f)
+
+    case_dir = os.path.abspath(args.case)
+    start = branch_time(case_dir, str(sweep.get("branchTime", "latestTime")))
+    concurrent = max_concurrent(
+        case_dir, args.concurrent or sweep.get("concurrent")
+    )
+    files_dir = os.path.dirname(os.path.abspath(args.variants))
+
+    print(f"Branching {len(sweep['variants'])} variants from time {start}")
+    variant_dirs = {
+        name: setup_variant(
+            case_dir, name, variant, start, sweep.get("endTime"), files_dir
+        )
+        for name, variant in sweep["variants"].items()
+    }
+
+    results = run_variants(variant_dirs, concurrent)
+
+    with open(os.path.join(case_dir, "sweep", "sweep.csv"), "w") as f:
+        f.write("variant,status,wall-clock time [s]\n")
+        for name, (status, wall_time) in results.items():
+            f.write(f"{name},{status},{wall_time:.1f}\n")
+
+    failed = [name for name, (status, _) in results.items() if status != 0]
+    for name in failed:
+        print(f"FAILED variant {name}, see {variant_dirs[name]}/log.directChillFoam")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())